@@ -0,0 +1,298 @@
+#pragma once
+#include "graph.h"
+#include <map>
+#include <vector>
+#include <algorithm>
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+namespace Graph
+{
+    /**
+     * @brief 图的紧凑邻接表(CSR)快照，Brandes计算期间只读共享
+     * 下标i的节点id为ids[i]，其出边目标为targets[offsets[i]..offsets[i+1])
+    */
+    struct Betweenness_Snapshot {
+        std::vector<int> ids;
+        std::vector<int> offsets;
+        std::vector<int> targets;
+        //无向图的每对节点会被两个源点各统计一次，归约后需要除以2
+        bool undirected = false;
+        int size() const { return static_cast<int>(ids.size()); }
+    };
+
+    /**
+     * @brief 把图转换为紧凑邻接表快照，之后的计算不再查询map
+     * @param graph 输入图
+     * @return 快照
+    */
+    Betweenness_Snapshot makeBetweennessSnapshot(Graph_Base& graph);
+
+    /**
+     * @brief 以[begin,end)范围内的节点为源点执行Brandes算法，把依赖值累加到partial
+     * @param snapshot 图快照
+     * @param begin 起始源点下标
+     * @param end 结束源点下标(不含)
+     * @param partial 部分依赖向量，长度为snapshot.size()
+     * @param stats 统计计数器；为空时在结束后合并到全局统计，仅在定义GRAPH_ENABLE_STATS时使用
+    */
+    void brandesRange(const Betweenness_Snapshot& snapshot, int begin, int end, double* partial, Graph_Stats_Local* stats = nullptr);
+
+    /**
+     * @brief 计算图中所有节点的介数中心性(不加权，未归一化)
+     * @param graph 输入图
+     * @return 节点id到介数的映射
+    */
+    std::map<int, double> betweenness(Graph_Base& graph);
+
+    /**
+     * @brief 分区版本：按源点范围把计算拆分给多个工作进程，由协调者归约各部分依赖向量
+     * Linux下工作进程通过fork继承只读快照，结果写入共享内存；
+     * 其它平台或创建进程失败时，由协调者在本进程内计算对应的范围
+     * @param graph 输入图
+     * @param workers 工作进程数
+     * @return 节点id到介数的映射，与betweenness()结果一致
+    */
+    std::map<int, double> betweenness_partitioned(Graph_Base& graph, int workers);
+}
+
+namespace Graph
+{
+    inline Betweenness_Snapshot makeBetweennessSnapshot(Graph_Base& graph)
+    {
+        GRAPH_STAT_PHASE("snapshot");
+        Betweenness_Snapshot snapshot;
+        snapshot.undirected = dynamic_cast<UnDirected_Graph*>(&graph) != nullptr;
+        std::map<int, int> index;
+        for (auto& id : graph.getAllNodes())
+        {
+            index[id] = snapshot.size();
+            snapshot.ids.push_back(id);
+        }
+        snapshot.offsets.reserve(snapshot.ids.size() + 1);
+        snapshot.offsets.push_back(0);
+        for (auto& id : snapshot.ids)
+        {
+            //getNearNode对无向图会同时返回两个方向的相邻节点
+            for (auto& near : graph.getNearNode(id))
+            {
+                //删除节点后可能残留指向不存在节点的边，跳过这些邻居
+                auto it = index.find(near);
+                if (it == index.end())
+                    continue;
+                snapshot.targets.push_back(it->second);
+            }
+            snapshot.offsets.push_back(static_cast<int>(snapshot.targets.size()));
+        }
+        return snapshot;
+    }
+
+    inline void brandesRange(const Betweenness_Snapshot& snapshot, int begin, int end, double* partial, Graph_Stats_Local* stats)
+    {
+#ifdef GRAPH_ENABLE_STATS
+        Graph_Stats_Local local;
+        Graph_Stats_Local& counters = stats ? *stats : local;
+#else
+        (void)stats;
+#endif
+        int n = snapshot.size();
+        std::vector<int> order;
+        std::vector<std::vector<int>> preds(n);
+        std::vector<double> sigma(n);
+        std::vector<double> delta(n);
+        std::vector<int> dist(n);
+        order.reserve(n);
+        for (int s = begin; s < end; s++)
+        {
+            order.clear();
+            for (int i = 0; i < n; i++)
+            {
+                preds[i].clear();
+                sigma[i] = 0.0;
+                delta[i] = 0.0;
+                dist[i] = -1;
+            }
+            sigma[s] = 1.0;
+            dist[s] = 0;
+            //BFS求最短路径数，order同时作为队列和出栈顺序
+            order.push_back(s);
+            for (size_t head = 0; head < order.size(); head++)
+            {
+                int v = order[head];
+                for (int e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++)
+                {
+                    int w = snapshot.targets[e];
+                    if (dist[w] < 0)
+                    {
+                        dist[w] = dist[v] + 1;
+                        order.push_back(w);
+                    }
+                    if (dist[w] == dist[v] + 1)
+                    {
+                        sigma[w] += sigma[v];
+                        preds[w].push_back(v);
+                    }
+                }
+            }
+#ifdef GRAPH_ENABLE_STATS
+            //在BFS之外统计，避免给内层循环增加开销；order中每个节点的出边都被扫描过一次
+            for (auto& w : order)
+            {
+                counters.edges_relaxed += snapshot.offsets[w + 1] - snapshot.offsets[w];
+                counters.recordFrontier(dist[w], 1);
+            }
+#endif
+            //按距离从远到近回溯累加依赖
+            for (auto it = order.rbegin(); it != order.rend(); ++it)
+            {
+                int w = *it;
+                for (auto& v : preds[w])
+                {
+                    delta[v] += sigma[v] / sigma[w] * (1.0 + delta[w]);
+                }
+                if (w != s)
+                    partial[w] += delta[w];
+            }
+        }
+#ifdef GRAPH_ENABLE_STATS
+        if (!stats)
+            counters.flush(Graph_Stats::instance());
+#endif
+    }
+
+    namespace Detail
+    {
+        inline std::map<int, double> reduceBetweenness(const Betweenness_Snapshot& snapshot, const double* partials, int parts)
+        {
+            GRAPH_STAT_PHASE("reduce");
+            std::map<int, double> result;
+            int n = snapshot.size();
+            for (int i = 0; i < n; i++)
+            {
+                double sum = 0.0;
+                for (int p = 0; p < parts; p++)
+                {
+                    sum += partials[static_cast<size_t>(p) * n + i];
+                }
+                result[snapshot.ids[i]] = snapshot.undirected ? sum / 2.0 : sum;
+            }
+            return result;
+        }
+    }
+
+    inline std::map<int, double> betweenness(Graph_Base& graph)
+    {
+        auto snapshot = makeBetweennessSnapshot(graph);
+        std::vector<double> partial(snapshot.size(), 0.0);
+        {
+            GRAPH_STAT_PHASE("brandes");
+            brandesRange(snapshot, 0, snapshot.size(), partial.data());
+        }
+        return Detail::reduceBetweenness(snapshot, partial.data(), 1);
+    }
+
+    inline std::map<int, double> betweenness_partitioned(Graph_Base& graph, int workers)
+    {
+        auto snapshot = makeBetweennessSnapshot(graph);
+        int n = snapshot.size();
+        workers = std::max(1, std::min(workers, n));
+        if (n == 0)
+            return std::map<int, double>();
+        //第p个分区负责源点[bounds[p],bounds[p+1])
+        std::vector<int> bounds(workers + 1);
+        for (int p = 0; p <= workers; p++)
+        {
+            bounds[p] = static_cast<int>(static_cast<long long>(n) * p / workers);
+        }
+        size_t bytes = sizeof(double) * static_cast<size_t>(workers) * n;
+#if defined(__linux__)
+        //共享匿名映射，fork后父子进程看到同一块内存，每个分区只写自己的那段
+#ifdef GRAPH_ENABLE_STATS
+        //工作进程的计数器打包在结果之后，由协调者合并；BFS层数不超过节点数
+        size_t statBlock = Graph_Stats::packedSize(n);
+        bytes += sizeof(uint64_t) * statBlock * workers;
+#endif
+        void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (region != MAP_FAILED)
+        {
+            double* partials = static_cast<double*>(region);
+            std::fill(partials, partials + static_cast<size_t>(workers) * n, 0.0);
+#ifdef GRAPH_ENABLE_STATS
+            uint64_t* stats = reinterpret_cast<uint64_t*>(partials + static_cast<size_t>(workers) * n);
+#endif
+            {
+                GRAPH_STAT_PHASE("brandes");
+                std::vector<pid_t> pids(workers, -1);
+                for (int p = 0; p < workers; p++)
+                {
+                    pid_t pid = fork();
+                    if (pid == 0)
+                    {
+                        //异常不能逃出子进程，否则子进程会继续执行调用者的代码；以非0状态退出，由协调者重新计算
+                        try
+                        {
+#ifdef GRAPH_ENABLE_STATS
+                            //只写本地计数器，继承来的全局对象的mutex可能被fork时的其它线程持有
+                            Graph_Stats_Local local;
+                            brandesRange(snapshot, bounds[p], bounds[p + 1], partials + static_cast<size_t>(p) * n, &local);
+                            local.pack(stats + statBlock * p, n);
+#else
+                            brandesRange(snapshot, bounds[p], bounds[p + 1], partials + static_cast<size_t>(p) * n);
+#endif
+                            _exit(0);
+                        }
+                        catch (...)
+                        {
+                            _exit(1);
+                        }
+                    }
+                    pids[p] = pid;
+                }
+                for (int p = 0; p < workers; p++)
+                {
+                    double* partial = partials + static_cast<size_t>(p) * n;
+                    bool ok = false;
+                    if (pids[p] > 0)
+                    {
+                        //被信号打断时重试，保证子进程已被回收后才会重新计算它的分区
+                        int status = 0;
+                        pid_t reaped;
+                        do
+                        {
+                            reaped = waitpid(pids[p], &status, 0);
+                        } while (reaped < 0 && errno == EINTR);
+                        ok = reaped == pids[p] && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                    }
+                    if (!ok)
+                    {
+                        //创建失败或异常退出的分区由协调者重新计算
+                        std::fill(partial, partial + n, 0.0);
+                        brandesRange(snapshot, bounds[p], bounds[p + 1], partial);
+                    }
+#ifdef GRAPH_ENABLE_STATS
+                    else
+                    {
+                        Graph_Stats::instance().merge(stats + statBlock * p, n);
+                    }
+#endif
+                }
+            }
+            auto result = Detail::reduceBetweenness(snapshot, partials, workers);
+            munmap(region, bytes);
+            return result;
+        }
+#endif
+        std::vector<double> partials(static_cast<size_t>(workers) * n, 0.0);
+        {
+            GRAPH_STAT_PHASE("brandes");
+            for (int p = 0; p < workers; p++)
+            {
+                brandesRange(snapshot, bounds[p], bounds[p + 1], partials.data() + static_cast<size_t>(p) * n);
+            }
+        }
+        return Detail::reduceBetweenness(snapshot, partials.data(), workers);
+    }
+}
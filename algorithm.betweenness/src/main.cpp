@@ -1,8 +1,97 @@
 #include "graph.h"
+#include "betweenness.h"
 #include <iostream>
+#include <cmath>
+
+#ifdef GRAPH_ENABLE_STATS
+//算法计数器：扫描的边数和每层前沿大小
+struct AlgorithmCounters {
+    uint64_t edges_relaxed = 0;
+    std::vector<uint64_t> frontier_sizes;
+};
+
+//读取当前的算法计数器
+static AlgorithmCounters readAlgorithmCounters()
+{
+    auto& stats = Graph::Graph_Stats::instance();
+    AlgorithmCounters counters;
+    counters.edges_relaxed = stats.edges_relaxed.load();
+    std::lock_guard<std::mutex> lock(stats.mutex);
+    counters.frontier_sizes = stats.frontier_sizes;
+    return counters;
+}
+
+//计算两次读取之间的增量，去掉末尾的0层
+static AlgorithmCounters diffAlgorithmCounters(const AlgorithmCounters& before, const AlgorithmCounters& after)
+{
+    AlgorithmCounters counters;
+    counters.edges_relaxed = after.edges_relaxed - before.edges_relaxed;
+    counters.frontier_sizes = after.frontier_sizes;
+    for (size_t i = 0; i < before.frontier_sizes.size(); i++)
+    {
+        counters.frontier_sizes[i] -= before.frontier_sizes[i];
+    }
+    while (!counters.frontier_sizes.empty() && counters.frontier_sizes.back() == 0)
+    {
+        counters.frontier_sizes.pop_back();
+    }
+    return counters;
+}
+#endif
+
+/**
+ * @brief 比较单进程与分区版本的介数，可选地与期望值比较
+ * @param name 测试名称
+ * @param graph 输入图
+ * @param expected 期望的介数，为空时不比较
+ * @return 全部一致返回true
+*/
+static bool checkBetweenness(const char* name, Graph::Graph_Base& graph, const std::map<int, double>& expected = {})
+{
+#ifdef GRAPH_ENABLE_STATS
+    auto before = readAlgorithmCounters();
+#endif
+    auto centrality = Graph::betweenness(graph);
+#ifdef GRAPH_ENABLE_STATS
+    auto middle = readAlgorithmCounters();
+#endif
+    auto centrality_partitioned = Graph::betweenness_partitioned(graph, 4);
+    bool ok = centrality.size() == centrality_partitioned.size();
+#ifdef GRAPH_ENABLE_STATS
+    //分区版本的计数器由工作进程打包后合并，应与单进程版本一致
+    auto serial = diffAlgorithmCounters(before, middle);
+    auto partitioned = diffAlgorithmCounters(middle, readAlgorithmCounters());
+    if (serial.edges_relaxed != partitioned.edges_relaxed || serial.frontier_sizes != partitioned.frontier_sizes)
+    {
+        std::cout << name << " stats mismatch: serial edges_relaxed " << serial.edges_relaxed
+            << ", partitioned " << partitioned.edges_relaxed << std::endl;
+        ok = false;
+    }
+#endif
+    for (auto& item : centrality)
+    {
+        double partitioned = centrality_partitioned[item.first];
+        std::cout << name << " " << item.first << ":" << item.second << "," << partitioned << std::endl;
+        if (std::fabs(item.second - partitioned) > 1e-9)
+        {
+            std::cout << name << " mismatch at node " << item.first << ": serial " << item.second
+                << ", partitioned " << partitioned << std::endl;
+            ok = false;
+        }
+        auto it = expected.find(item.first);
+        if (it != expected.end() && std::fabs(item.second - it->second) > 1e-9)
+        {
+            std::cout << name << " mismatch at node " << item.first << ": expected " << it->second
+                << ", got " << item.second << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
 
 int main()
 {
+    bool ok = true;
     Graph::UnDirected_Graph directed_graph;
     directed_graph.add_nodes({ 1,2,3,4,5,6,7 });
     directed_graph.add_edges({
@@ -32,8 +121,41 @@ int main()
     auto edges = directed_graph.getAllEdges();
     //测试获取邻边
     auto edge = directed_graph.getNearEdges(3);
+    //测试介数中心性，分区版本应与单进程结果一致
+    ok &= checkBetweenness("undirected", directed_graph, { {1,0.5},{2,0.75},{3,2.5},{4,0},{5,2.5},{6,3},{7,0.75} });
+#ifdef GRAPH_ENABLE_STATS
+    //输出并检查统计信息：7个节点各3个map条目，12条无向边各2个条目；
+    //单进程和分区各运行一次，每次7个源点各扫描24条边
+    auto& stats = Graph::Graph_Stats::instance();
+    std::cout << stats.toJson() << std::endl;
+    auto counters = readAlgorithmCounters();
+    if (stats.map_insertions.load() != 45 || counters.edges_relaxed != 336
+        || counters.frontier_sizes.empty() || counters.frontier_sizes[0] != 14)
+    {
+        std::cout << "stats mismatch: expected map_insertions 45, edges_relaxed 336, frontier_sizes[0] 14" << std::endl;
+        ok = false;
+    }
+#endif
     //测试删除节点
     directed_graph.remove_node(3);
     //测试删除边
     directed_graph.remove_edges({ { 1,2 }, { 6,1 } });
+    ok &= checkBetweenness("undirected_removed", directed_graph);
+
+    //有向图：1->2->3->4，节点2和3各位于2条最短路径的中间
+    Graph::Directed_Graph real_directed_graph;
+    real_directed_graph.add_nodes({ 1,2,3,4 });
+    real_directed_graph.add_edges({ {1,2},{2,3},{3,4} });
+    ok &= checkBetweenness("directed", real_directed_graph, { {1,0},{2,2},{3,2},{4,0} });
+
+    //删除节点后残留的边不能被计入：1-2-3-4删除3后，剩余节点介数全为0
+    Graph::UnDirected_Graph path_graph;
+    path_graph.add_nodes({ 1,2,3,4 });
+    path_graph.add_edges({ {1,2},{2,3},{3,4} });
+    path_graph.remove_node(3);
+    ok &= checkBetweenness("removed_node", path_graph, { {1,0},{2,0},{4,0} });
+
+    if (!ok)
+        std::cout << "betweenness check failed" << std::endl;
+    return ok ? 0 : 1;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include "graph_stats.h"
 namespace Graph
 {
     struct Graph_Node {
@@ -256,19 +257,31 @@ namespace Graph
 namespace Graph
 {
     inline bool UnDirected_Graph::add_node(int id) {
+        GRAPH_STAT_LOOKUP(1);
         if (m_nodes.find(id) != m_nodes.end()) return false;
-        m_nodes[id] = Graph_Node(id);
-        m_edges.emplace(id, std::map<int, Graph_Edge>());
-        m_edges_inv.emplace(id, std::map<int, Graph_Edge>());
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.emplace(id, Graph_Node(id)).second)
+            GRAPH_STAT_INSERT(1);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_edges.emplace(id, std::map<int, Graph_Edge>()).second)
+            GRAPH_STAT_INSERT(1);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_edges_inv.emplace(id, std::map<int, Graph_Edge>()).second)
+            GRAPH_STAT_INSERT(1);
         return true;
     }
 
     inline bool UnDirected_Graph::remove_node(int id) {
+        GRAPH_STAT_LOOKUP(1);
         if (m_nodes.find(id) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
         m_nodes.erase(id);
+        GRAPH_STAT_LOOKUP(1);
         m_edges.erase(id);
+        GRAPH_STAT_LOOKUP(1);
         m_edges_inv.erase(id);
         for (auto& edge : m_edges) {
+            GRAPH_STAT_LOOKUP(1);
             if (edge.second.find(id) != edge.second.end()) {
                 remove_edge(edge.first, id);
             }
@@ -280,18 +293,40 @@ namespace Graph
         if (from == to) return false;//不允许自环
         if (from > to)
             std::swap(from, to);
-        if (m_nodes.find(from) == m_nodes.end() || m_nodes.find(to) == m_nodes.end()) return false;
-        m_edges[from][to] = Graph_Edge(from, to, weight);
-        m_edges_inv[to][from] = Graph_Edge(to, from, weight);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(from) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(to) == m_nodes.end()) return false;
+        //emplace不会覆盖已有的边，只有新插入的键才计入统计
+        GRAPH_STAT_LOOKUP(2);
+        auto edge = m_edges[from].emplace(to, Graph_Edge(from, to, weight));
+        if (edge.second)
+            GRAPH_STAT_INSERT(1);
+        else
+            edge.first->second = Graph_Edge(from, to, weight);
+        GRAPH_STAT_LOOKUP(2);
+        auto edge_inv = m_edges_inv[to].emplace(from, Graph_Edge(to, from, weight));
+        if (edge_inv.second)
+            GRAPH_STAT_INSERT(1);
+        else
+            edge_inv.first->second = Graph_Edge(to, from, weight);
         return true;
     }
 
     inline bool UnDirected_Graph::remove_edge(int from, int to) {
         if (from > to)
             std::swap(from, to);
-        if (m_nodes.find(from) == m_nodes.end() || m_nodes.find(to) == m_nodes.end()) return false;
-        if (m_edges[from].find(to) == m_edges[from].end() || m_edges[from].find(to) == m_edges[from].end()) return false;
-        m_edges[from].erase(to);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(from) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(to) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        auto& near_edges = m_edges[from];
+        GRAPH_STAT_LOOKUP(1);
+        if (near_edges.find(to) == near_edges.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        near_edges.erase(to);
+        GRAPH_STAT_LOOKUP(2);
         m_edges_inv[to].erase(from);
         return true;
     }
@@ -312,6 +347,7 @@ namespace Graph
     inline std::set<int> UnDirected_Graph::getNearNode(int id)
     {
         auto nodes = Graph_Base::getNearNode(id);
+        GRAPH_STAT_LOOKUP(1);
         for (auto& edge : m_edges_inv[id])
         {
             nodes.emplace(edge.second.to);
@@ -322,6 +358,7 @@ namespace Graph
     inline std::set<std::pair<int, int>> UnDirected_Graph::getNearEdges(int id)
     {
         auto edges = Graph_Base::getNearEdges(id);
+        GRAPH_STAT_LOOKUP(1);
         for (auto& edge : m_edges_inv[id])
         {
             edges.emplace(edge.second.from, edge.second.to);
@@ -330,18 +367,28 @@ namespace Graph
     }
 
     inline bool Directed_Graph::add_node(int id) {
+        GRAPH_STAT_LOOKUP(1);
         if (m_nodes.find(id) != m_nodes.end()) return false;
-        m_nodes[id] = Graph_Node(id);
-        m_edges.emplace(id, std::map<int, Graph_Edge>());
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.emplace(id, Graph_Node(id)).second)
+            GRAPH_STAT_INSERT(1);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_edges.emplace(id, std::map<int, Graph_Edge>()).second)
+            GRAPH_STAT_INSERT(1);
         return true;
     }
 
     inline bool Directed_Graph::remove_node(int id) {
+        GRAPH_STAT_LOOKUP(1);
         if (m_nodes.find(id) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
         m_nodes.erase(id);
+        GRAPH_STAT_LOOKUP(1);
         m_edges.erase(id);
         for (auto& edge : m_edges) {
+            GRAPH_STAT_LOOKUP(1);
             if (edge.second.find(id) != edge.second.end()) {
+                GRAPH_STAT_LOOKUP(1);
                 edge.second.erase(id);
             }
         }
@@ -350,15 +397,31 @@ namespace Graph
 
     inline bool Directed_Graph::add_edge(int from, int to, float weight) {
         if (from == to) return false;//不允许自环
-        if (m_nodes.find(from) == m_nodes.end() || m_nodes.find(to) == m_nodes.end()) return false;
-        m_edges[from][to] = Graph_Edge(from, to, weight);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(from) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(to) == m_nodes.end()) return false;
+        //emplace不会覆盖已有的边，只有新插入的键才计入统计
+        GRAPH_STAT_LOOKUP(2);
+        auto edge = m_edges[from].emplace(to, Graph_Edge(from, to, weight));
+        if (edge.second)
+            GRAPH_STAT_INSERT(1);
+        else
+            edge.first->second = Graph_Edge(from, to, weight);
         return true;
     }
 
     inline bool Directed_Graph::remove_edge(int from, int to) {
-        if (m_nodes.find(from) == m_nodes.end() || m_nodes.find(to) == m_nodes.end()) return false;
-        if (m_edges[from].find(to) == m_edges[from].end() || m_edges[from].find(to) == m_edges[from].end()) return false;
-        m_edges[from].erase(to);
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(from) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        if (m_nodes.find(to) == m_nodes.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        auto& near_edges = m_edges[from];
+        GRAPH_STAT_LOOKUP(1);
+        if (near_edges.find(to) == near_edges.end()) return false;
+        GRAPH_STAT_LOOKUP(1);
+        near_edges.erase(to);
         return true;
     }
 
@@ -451,6 +514,7 @@ namespace Graph
     inline std::set<int> Graph_Base::getNearNode(int id)
     {
         std::set<int> nodes;
+        GRAPH_STAT_LOOKUP(1);
         for (auto& edges : m_edges[id])
         {
             nodes.insert(edges.second.to);
@@ -476,6 +540,7 @@ namespace Graph
     inline std::set<std::pair<int, int>> Graph_Base::getNearEdges(int id)
     {
         std::set<std::pair<int, int>> edges;
+        GRAPH_STAT_LOOKUP(1);
         for (auto& edge : m_edges[id])
         {
             edges.insert(std::make_pair(id, edge.second.to));
@@ -563,6 +628,7 @@ namespace Graph
     inline Graph_Base::NearNodeIterator Graph_Base::NearNodeIterator::beginIterator(Graph_Base& graph, int id)
     {
         auto iter = NearNodeIterator(graph, id);
+        GRAPH_STAT_LOOKUP(1);
         iter.m_iterNearEdges = graph.m_edges[id].begin();
         return iter;
     }
@@ -570,11 +636,13 @@ namespace Graph
     inline Graph_Base::NearNodeIterator Graph_Base::NearNodeIterator::endIterator(Graph_Base& graph, int id)
     {
         auto iter = NearNodeIterator(graph, id);
+        GRAPH_STAT_LOOKUP(1);
         iter.m_iterNearEdges = graph.m_edges[id].end();
         return iter;
     }
 
     inline Graph_Node& Graph_Base::NearNodeIterator::operator*() {
+        GRAPH_STAT_LOOKUP(1);
         return graph.m_nodes[m_iterNearEdges->second.from];
     }
 
@@ -587,12 +655,14 @@ namespace Graph
     }
 
     inline Graph_Base::NearEdgeIterator::NearEdgeIterator(Graph_Base& graph, int id) :graph(graph) {
+        GRAPH_STAT_LOOKUP(1);
         m_iterNearEdges = graph.m_edges[id].begin();
     }
 
     inline Graph_Base::NearEdgeIterator Graph_Base::NearEdgeIterator::beginIterator(Graph_Base& graph, int id)
     {
         auto iter = NearEdgeIterator(graph, id);
+        GRAPH_STAT_LOOKUP(1);
         iter.m_iterNearEdges = graph.m_edges[id].begin();
         return iter;
     }
@@ -600,6 +670,7 @@ namespace Graph
     inline Graph_Base::NearEdgeIterator Graph_Base::NearEdgeIterator::endIterator(Graph_Base& graph, int id)
     {
         auto iter = NearEdgeIterator(graph, id);
+        GRAPH_STAT_LOOKUP(1);
         iter.m_iterNearEdges = graph.m_edges[id].end();
         return iter;
     }
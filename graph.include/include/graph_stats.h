@@ -0,0 +1,220 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <sstream>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+namespace Graph
+{
+    /**
+     * @brief 图操作与算法的热路径统计
+     * 只有定义了GRAPH_ENABLE_STATS时，下方的GRAPH_STAT_*宏才会记录数据；
+     * 未定义时宏展开为空语句，不产生任何开销，统计对象始终为空
+     * 线程安全：标量计数器为std::atomic，用relaxed顺序累加；
+     * frontier_sizes和phase_seconds由mutex保护，读取它们请使用toJson()或加锁
+    */
+    struct Graph_Stats {
+        //按键访问map的次数(find/operator[]/emplace/erase)，每次访问计1
+        std::atomic<uint64_t> map_lookups{ 0 };
+        //新插入的节点和边的map条目数，覆盖已有的边不计入
+        std::atomic<uint64_t> map_insertions{ 0 };
+        //算法中扫描过的边数
+        std::atomic<uint64_t> edges_relaxed{ 0 };
+        //BFS每一层的前沿大小，下标为层数，对所有源点累加
+        std::vector<uint64_t> frontier_sizes;
+        //各阶段耗时(秒)，多线程时为所有线程耗时之和
+        std::map<std::string, double> phase_seconds;
+        //保护frontier_sizes和phase_seconds
+        mutable std::mutex mutex;
+
+        //获取全局统计对象
+        static Graph_Stats& instance();
+        //清空所有统计
+        void reset();
+        //记录第level层新增的前沿节点数
+        void recordFrontier(int level, uint64_t count);
+        //把耗时累加到name阶段
+        void recordPhase(const std::string& name, double seconds);
+        //以JSON格式导出统计
+        std::string toJson() const;
+
+        /**
+         * @brief 计数器打包后的长度，用于跨进程传递
+         * @param levels 最多传递的层数
+         * @return uint64_t的个数
+        */
+        static size_t packedSize(int levels);
+        //把计数器打包到out，长度为packedSize(levels)
+        void pack(uint64_t* out, int levels) const;
+        //把打包的计数器累加到当前对象
+        void merge(const uint64_t* in, int levels);
+    };
+
+    /**
+     * @brief 算法内部使用的本地计数器，不加锁
+     * 算法只写本地计数器，结束时用flush()一次性合并到全局对象，
+     * 或用pack()写入共享内存由协调者合并(fork出的子进程不能触碰继承来的全局对象及其mutex)
+    */
+    struct Graph_Stats_Local {
+        uint64_t edges_relaxed = 0;
+        std::vector<uint64_t> frontier_sizes;
+
+        //记录第level层新增的前沿节点数
+        void recordFrontier(int level, uint64_t count);
+        //合并到stats，只加一次锁
+        void flush(Graph_Stats& stats) const;
+        //按Graph_Stats::pack的布局打包，长度为Graph_Stats::packedSize(levels)
+        void pack(uint64_t* out, int levels) const;
+    };
+
+    //RAII计时器，析构时把耗时累加到对应阶段
+    class Graph_Stats_Phase {
+        std::string name;
+        std::chrono::steady_clock::time_point start;
+    public:
+        Graph_Stats_Phase(const char* name) : name(name), start(std::chrono::steady_clock::now()) {}
+        ~Graph_Stats_Phase();
+    };
+}
+
+#define GRAPH_STAT_CONCAT_IMPL(a, b) a##b
+#define GRAPH_STAT_CONCAT(a, b) GRAPH_STAT_CONCAT_IMPL(a, b)
+#ifdef GRAPH_ENABLE_STATS
+#define GRAPH_STAT_LOOKUP(n) (::Graph::Graph_Stats::instance().map_lookups.fetch_add((n), std::memory_order_relaxed))
+#define GRAPH_STAT_INSERT(n) (::Graph::Graph_Stats::instance().map_insertions.fetch_add((n), std::memory_order_relaxed))
+#define GRAPH_STAT_PHASE(name) ::Graph::Graph_Stats_Phase GRAPH_STAT_CONCAT(graph_stat_phase_, __LINE__)(name)
+#else
+#define GRAPH_STAT_LOOKUP(n) ((void)0)
+#define GRAPH_STAT_INSERT(n) ((void)0)
+#define GRAPH_STAT_PHASE(name) ((void)0)
+#endif
+
+namespace Graph
+{
+    inline Graph_Stats& Graph_Stats::instance()
+    {
+        static Graph_Stats stats;
+        return stats;
+    }
+
+    inline void Graph_Stats::reset()
+    {
+        map_lookups = 0;
+        map_insertions = 0;
+        edges_relaxed = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        frontier_sizes.clear();
+        phase_seconds.clear();
+    }
+
+    inline void Graph_Stats::recordFrontier(int level, uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frontier_sizes.size() <= static_cast<size_t>(level))
+            frontier_sizes.resize(level + 1, 0);
+        frontier_sizes[level] += count;
+    }
+
+    inline void Graph_Stats::recordPhase(const std::string& name, double seconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        phase_seconds[name] += seconds;
+    }
+
+    inline std::string Graph_Stats::toJson() const
+    {
+        std::ostringstream out;
+        out << "{\"map_lookups\":" << map_lookups.load()
+            << ",\"map_insertions\":" << map_insertions.load()
+            << ",\"edges_relaxed\":" << edges_relaxed.load()
+            << ",\"frontier_sizes\":[";
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < frontier_sizes.size(); i++)
+        {
+            if (i != 0) out << ",";
+            out << frontier_sizes[i];
+        }
+        out << "],\"phase_seconds\":{";
+        bool first = true;
+        for (auto& phase : phase_seconds)
+        {
+            if (!first) out << ",";
+            first = false;
+            out << "\"" << phase.first << "\":" << phase.second;
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    inline size_t Graph_Stats::packedSize(int levels)
+    {
+        return 3 + static_cast<size_t>(levels);
+    }
+
+    inline void Graph_Stats::pack(uint64_t* out, int levels) const
+    {
+        out[0] = map_lookups;
+        out[1] = map_insertions;
+        out[2] = edges_relaxed;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < levels; i++)
+        {
+            out[3 + i] = static_cast<size_t>(i) < frontier_sizes.size() ? frontier_sizes[i] : 0;
+        }
+    }
+
+    inline void Graph_Stats::merge(const uint64_t* in, int levels)
+    {
+        map_lookups += in[0];
+        map_insertions += in[1];
+        edges_relaxed += in[2];
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < levels; i++)
+        {
+            if (in[3 + i] == 0)
+                continue;
+            if (frontier_sizes.size() <= static_cast<size_t>(i))
+                frontier_sizes.resize(i + 1, 0);
+            frontier_sizes[i] += in[3 + i];
+        }
+    }
+
+    inline void Graph_Stats_Local::recordFrontier(int level, uint64_t count)
+    {
+        if (frontier_sizes.size() <= static_cast<size_t>(level))
+            frontier_sizes.resize(level + 1, 0);
+        frontier_sizes[level] += count;
+    }
+
+    inline void Graph_Stats_Local::flush(Graph_Stats& stats) const
+    {
+        stats.edges_relaxed.fetch_add(edges_relaxed, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        if (stats.frontier_sizes.size() < frontier_sizes.size())
+            stats.frontier_sizes.resize(frontier_sizes.size(), 0);
+        for (size_t i = 0; i < frontier_sizes.size(); i++)
+        {
+            stats.frontier_sizes[i] += frontier_sizes[i];
+        }
+    }
+
+    inline void Graph_Stats_Local::pack(uint64_t* out, int levels) const
+    {
+        out[0] = 0;
+        out[1] = 0;
+        out[2] = edges_relaxed;
+        for (int i = 0; i < levels; i++)
+        {
+            out[3 + i] = static_cast<size_t>(i) < frontier_sizes.size() ? frontier_sizes[i] : 0;
+        }
+    }
+
+    inline Graph_Stats_Phase::~Graph_Stats_Phase()
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        Graph_Stats::instance().recordPhase(name, elapsed.count());
+    }
+}